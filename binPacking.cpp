@@ -12,15 +12,37 @@
 #include <algorithm>
 #include <numeric>
 #include <chrono>
+#include <thread>
 #include "binPackingExceptions.hpp"
+#include "solverService.hpp"
 
 /* Main function run by the executable */
 int main(int argc, char const *argv[])
 {
     try
     {
+        // If run as a service, read jobs from stdin or a socket instead of running trials
+        if (argc >= 2 and string(argv[1]) == "--serve")
+        {
+            // Check for invalid number of args
+            if (argc > 3)
+                throw new InvalidArgsException;
+
+            // Run one worker per hardware thread, keep up to 8 built graphs cached,
+            // queue up to 1024 jobs and accept up to 64 connections at once
+            SolverService service(thread::hardware_concurrency(), 8, 1024, 64);
+
+            // If a socket path is given, listen on it, otherwise read from stdin
+            if (argc == 3)
+                service.serveSocket(argv[2]);
+            else
+                service.serve(cin, cout);
+
+            return 0;
+        }
+
         // Check for invalid number of args
-        if (argc != 4)
+        if (argc != 4 and argc != 5)
             throw new InvalidArgsException;
 
         // Check formatting of problem type
@@ -49,9 +71,21 @@ int main(int argc, char const *argv[])
         if (evaporation < 0)
             throw new InvalidEvaporationRateException;
 
+        // Check formatting of candidate list size (optional, 0 disables candidate lists)
+        int candidateSize = 0;
+        if (argc == 5)
+        {
+            string candidateSizeStr = argv[4];
+            candidateSize = stoi(candidateSizeStr);
+        }
+
+        // Check that candidate list size is not negative
+        if (candidateSize < 0)
+            throw new InvalidCandidateSizeException;
+
         // Passed all exception checks, now start the 5 ACO trials
         for (int i = 0; i < 5; i++)
-            start(problemType, numAnts, evaporation);
+            start(problemType, numAnts, evaporation, candidateSize);
 
         // Output when all 5 ACO trials are complete
         cout << "ACO Trial Complete" << endl;
@@ -79,7 +113,21 @@ int main(int argc, char const *argv[])
     {
         // Exception where the wrong number of arguments are supplied
         cerr << e->what() << endl;
-        cout << "Usage: " << argv[0] << " PROBLEM NUM_ANTS EVAPORATION_RATE" << endl;
+        cout << "Usage: " << argv[0] << " PROBLEM NUM_ANTS EVAPORATION_RATE [CANDIDATE_LIST_SIZE]" << endl;
+        cout << "       " << argv[0] << " --serve [SOCKET_PATH]" << endl;
+        exit(-1);
+    }
+    catch (InvalidCandidateSizeException *e)
+    {
+        // Exception where candidate list size is < 0
+        cerr << e->what() << endl;
+        cout << "Candidate List Size must be 0 (disabled) or greater" << endl;
+        exit(-1);
+    }
+    catch (ServiceSocketException const &e)
+    {
+        // Exception where the service socket could not be opened
+        cerr << e.what() << endl;
         exit(-1);
     }
     catch (InvalidProblemException *e)
@@ -105,13 +153,17 @@ int main(int argc, char const *argv[])
     }
 }
 
-void start(int problemType, int numAnts, float evaporation)
+void start(int problemType, int numAnts, float evaporation, int candidateSize)
 {
     // Output given problem type, number of ants and evaporation rate
     cout << "Problem Type: " << problemType << endl;
     cout << "Number of Ants: " << numAnts << endl;
     cout << "Evaporation Rate: " << evaporation << endl;
 
+    // Output candidate list size, if candidate lists are enabled
+    if (candidateSize > 0)
+        cout << "Candidate List Size: " << candidateSize << endl;
+
     // Set up constant values (number of items is always 500)
     int numItems = 500;
     int itemWeights [500];
@@ -138,92 +190,89 @@ void start(int problemType, int numAnts, float evaporation)
         }
     }
     
-    // Set up random pheromone selection variables and seed RNG
-    const int FLOAT_MIN = 0;
-    const int FLOAT_MAX = 1;
-    srand(time(nullptr));
+    // Create the construction graph for the problem, then seed it and give it random pheromones
+    Graph acoGraph = buildGraph(problemType, numBins, numItems);
+    acoGraph.seed(time(nullptr));
+    acoGraph.resetPheromone();
+    acoGraph.setCandidateSize(candidateSize);
+
+    // Create a system_clock variable to track time
+    auto start = chrono::system_clock::now();
+    // Get the current time before running trials
+    time_t startTime = chrono::system_clock::to_time_t(start);
+    // Output start time of current trial
+    cout << "Started computation at: " << ctime(&startTime) << endl;
+
+    // Run 10,000 fitness evaluations and keep the best fitness found
+    double best = runTrial(acoGraph, numAnts, evaporation, 10000);
+
+    // Get current system time for end of trial
+    auto end = chrono::system_clock::now();
+    time_t endTime = chrono::system_clock::to_time_t(end);
+    // Output end of trial time
+    cout << "Finished computation at: " << ctime(&endTime) << endl;
+
+    // Calculate the time difference (in seconds) between start and end time of trial
+    std::chrono::duration<double> elapsedSeconds = end - start;
+    cout << "Elapsed Time: " << elapsedSeconds.count() << endl;
+
+    // Output best ant fitness of trial
+    cout << "Best Ant Fitness: " << best << endl;
+}
 
-    // Calculate number of edges and create a vector of edges
-    int numEdges = (numBins * numItems) + 2;
+Graph buildGraph(int problemType, int numBins, int numItems)
+{
+    // Every edge starts with the same pheromone (random pheromones are set by Graph::resetPheromone,
+    // so that building does not depend on a shared random number generator)
+    const float START_PHEROMONE = 1.0;
+
+    // Calculate number of edges (every bin to every bin between layers, plus the root and output edges) and create a vector of edges
+    size_t numEdges = (size_t) numBins * numBins * (numItems - 1) + 2 * numBins;
     vector<Edge> edges;
     edges.reserve(numEdges);
 
-    // Create a vector of nodes and populate with index number
-    vector<int> nodes(numItems * numBins);
-    iota(begin(nodes), end(nodes), 1);
-    
-    // Create a vector of vectors, as well as a temporary vector for manipulation
-    vector< vector<int> > subVecs;
-    vector<int> temp;
-
-    // Split vector of all nodes into sub-vectors of size `numBins`
-    // Each sub-vector is equivalent to each layer in the construction graph
-    int lastNum = 0;
-    for (int i = 1; i < numItems + 1; i++)
-    {
-        for (int j = 1; j < numBins + 1; j++)
-        {
-            temp.push_back(j + lastNum);
-        }
-        subVecs.push_back(temp);
-        lastNum += numBins;
-        temp.clear();
-    }
+    // Nodes are numbered layer by layer, so node n (from 1) is in layer (n - 1) / numBins and bin (n - 1) % numBins + 1
+    int numLayerNodes = numItems * numBins;
 
-    // Create start (root) node 0
-    for (auto &nextNode: subVecs.at(0))
+    // Create start (root) node 0, connected to every node in the first layer
+    for (int nextNode = 1; nextNode <= numBins; nextNode++)
     {
-        float pheromone = FLOAT_MIN + (float)(rand()) / ((float)(RAND_MAX/(FLOAT_MAX - FLOAT_MIN)));
-        edges.push_back({0, nextNode, pheromone, 1});
+        edges.push_back({0, nextNode, START_PHEROMONE, 1});
     }
 
-    // Iterate over all nodes, find sub-vector they belong to
-    for (auto &node: nodes)
+    // Iterate over all nodes, calculating the layer and bin of each
+    for (int node = 1; node <= numLayerNodes; node++)
     {
-        for (auto &subVec: subVecs)
+        int index = (node - 1) / numBins;
+        int bin = (node - 1) % numBins + 1;
+
+        // If the node is not in the final layer
+        if (index != numItems - 1)
         {
-            // If the current node is found in the current sub-vector
-            if (binary_search(subVec.begin(), subVec.end(), node))
+            // Create an edge from current node to every node in the next layer
+            int firstNextNode = (index + 1) * numBins + 1;
+            for (int nextNode = firstNextNode; nextNode < firstNextNode + numBins; nextNode++)
             {
-                // Calculate the index of said node in sub-vector
-                auto it = find(subVecs.begin(), subVecs.end(), subVec);
-                int index = it - subVecs.begin();
-
-                // If the node is not in the final layer
-                if (index != numItems - 1)
-                {
-                    // Calculate the bin for the node
-                    auto binit = find(subVec.begin(), subVec.end(), node);
-                    int bin = binit - subVec.begin() + 1;
-
-                    // Create an edge from current node to every node in the next layer (sub-vector)
-                    for (auto &nextNode: subVecs.at(index + 1))
-                    {
-                        float pheromone = FLOAT_MIN + (float)(rand()) / ((float)(RAND_MAX/(FLOAT_MAX - FLOAT_MIN)));
-                        edges.push_back({node, nextNode, pheromone, bin});
-                    }
-                }
-                // If the node is in the final layer, it is only connected to one node
-                else
-                {
-                    // Calculate bin for the node
-                    auto binit = find(subVec.begin(), subVec.end(), node);
-                    int bin = binit - subVec.begin() + 1;
-                    
-                    // Create a single edge from current node to the single output node
-                    int nextNode = (numItems * numBins) + 1;
-                    edges.push_back({node, nextNode, 1.0, bin});
-                }
-                break;
+                edges.push_back({node, nextNode, START_PHEROMONE, bin});
             }
         }
+        // If the node is in the final layer, it is only connected to one node
+        else
+        {
+            // Create a single edge from current node to the single output node
+            int nextNode = numLayerNodes + 1;
+            edges.push_back({node, nextNode, 1.0, bin});
+        }
     }
 
     // Create a new construction graph using the previously calculated edges
-    Graph acoGraph(edges, (numItems * numBins + 2), numBins, problemType);
+    return Graph(edges, (numItems * numBins + 2), numBins, problemType);
+}
 
+double runTrial(Graph &acoGraph, int numAnts, float evaporation, int budget)
+{
     // This tracks the best fitness found in the trial
-    double best = pow(numItems, 2) * numBins;
+    double best = pow(acoGraph.getNumItems(), 2) * acoGraph.getNumBins();
 
     // Initialise a vector of paths
     vector< vector<int> > paths;
@@ -234,15 +283,8 @@ void start(int problemType, int numAnts, float evaporation)
     // Initialise a single vector for the current path
     vector<int> path;
 
-    // Create a system_clock variable to track time
-    auto start = chrono::system_clock::now();
-    // Get the current time before running trials
-    time_t startTime = chrono::system_clock::to_time_t(start);
-    // Output start time of current trial
-    cout << "Started computation at: " << ctime(&startTime) << endl;
-
-    // Start loop of 10,000 fitness evaluations
-    for (int i = 0; i < 10000; i++)
+    // Start loop of fitness evaluations
+    for (int i = 0; i < budget; i++)
     {
         // Generate a new path for each ant
         for (int i = 0; i < numAnts; i++)
@@ -274,18 +316,9 @@ void start(int problemType, int numAnts, float evaporation)
             best = tempBest;
         }
     }
-    // Get current system time for end of trial
-    auto end = chrono::system_clock::now();
-    time_t endTime = chrono::system_clock::to_time_t(end);
-    // Output end of trial time
-    cout << "Finished computation at: " << ctime(&endTime) << endl;
-
-    // Calculate the time difference (in seconds) between start and end time of trial
-    std::chrono::duration<double> elapsedSeconds = end - start;
-    cout << "Elapsed Time: " << elapsedSeconds.count() << endl;
 
-    // Output best ant fitness of trial
-    cout << "Best Ant Fitness: " << best << endl;
+    // Return the best fitness found
+    return best;
 }
 
 void printGraph(Graph const &graph, unsigned int numItems)
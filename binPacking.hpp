@@ -8,7 +8,13 @@
 /*-- Function Prototypes --*/
 
 /* Runs a single ACO trial */
-void start(int, int, float);
+void start(int, int, float, int);
+
+/* Builds the construction graph for a given problem type, number of bins and number of items */
+Graph buildGraph(int, int, int);
+
+/* Runs a given number of fitness evaluations on a graph, returning the best fitness found */
+double runTrial(Graph &, int, float, int);
 
 /* Prints all edges from a given node, in a given graph */
 void printGraph(Graph const &, unsigned int);
@@ -50,5 +50,55 @@ class InvalidEvaporationRateException: public exception
         }
 };
 
+/* Candidate list size supplied is invalid */
+class InvalidCandidateSizeException: public exception
+{
+    public:
+        virtual const char *what() const throw()
+        {
+            return "Error: Invalid candidate list size supplied";
+        }
+};
+
+/* Job request supplied to the service is malformed */
+class InvalidJobException: public exception
+{
+    public:
+        virtual const char *what() const throw()
+        {
+            return "Error: Invalid job request supplied";
+        }
+};
+
+/* Number of bins or items supplied is invalid */
+class InvalidInstanceException: public exception
+{
+    public:
+        virtual const char *what() const throw()
+        {
+            return "Error: Invalid number of bins or items supplied";
+        }
+};
+
+/* Budget (number of fitness evaluations) supplied is invalid */
+class InvalidBudgetException: public exception
+{
+    public:
+        virtual const char *what() const throw()
+        {
+            return "Error: Invalid budget supplied";
+        }
+};
+
+/* Socket for the service could not be opened */
+class ServiceSocketException: public exception
+{
+    public:
+        virtual const char *what() const throw()
+        {
+            return "Error: Unable to open service socket";
+        }
+};
+
 /*-- End of Header --*/
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <random>
 #include <cmath>
+#include <numeric>
 
 Graph::Graph(std::vector<Edge> const &edges, unsigned int numNodes, unsigned int numBins, unsigned int problemType)
 {
@@ -22,6 +23,9 @@ Graph::Graph(std::vector<Edge> const &edges, unsigned int numNodes, unsigned int
     this->problemType = problemType;
     this->numItems = (numNodes - 2) / numBins;
 
+    // Candidate lists are disabled by default, so every edge is scanned when picking the next node
+    this->setCandidateSize(0);
+
     // For each edge in edges
     for (auto &edge: edges)
     {
@@ -39,6 +43,153 @@ Graph::Graph(std::vector<Edge> const &edges, unsigned int numNodes, unsigned int
     }
 }
 
+unsigned int Graph::getNumBins() const
+{
+    // Retrieve the number of bins (the width of each layer)
+    return this->numBins;
+}
+
+unsigned int Graph::getNumItems() const
+{
+    // Retrieve the number of items (the number of layers)
+    return this->numItems;
+}
+
+void Graph::seed(unsigned int seed)
+{
+    // Seed the random number generator, so each graph can generate paths independently
+    this->rng.seed(seed);
+}
+
+void Graph::resetPheromone()
+{
+    // Sets every edge that involves a choice to a random pheromone in range 0 to 1
+    std::uniform_real_distribution<float> distribution(0.0, 1.0);
+
+    // Calculate the index of the final layer (final layer edges have no choice, so are left as is)
+    unsigned int finalLayerNode = (this->numNodes - 1) - this->numBins;
+
+    // For every node before the final layer
+    for (unsigned int node = 0; node < finalLayerNode; node++)
+    {
+        // For every edge from that node, pick a new random pheromone
+        for (auto &edge: this->adjList[node])
+        {
+            std::get<1>(edge) = distribution(this->rng);
+        }
+    }
+
+    // Candidate lists no longer match the pheromones, so rebuild them as they are next needed
+    this->setCandidateSize(this->candidateSize);
+}
+
+void Graph::setCandidateSize(unsigned int candidateSize)
+{
+    // Set the candidate list size and clear all candidate lists (each is built the first time its node is visited)
+    this->candidateSize = candidateSize;
+    this->candidates.assign(this->numNodes, std::vector<unsigned int>());
+    this->isCandidate.assign(this->numNodes, std::vector<bool>());
+    this->rowSums.assign(this->numNodes, 0);
+}
+
+void Graph::buildCandidates(unsigned int item)
+{
+    // Builds the candidate list for a node, made up of the edges with the highest pheromone
+    std::vector<Triple> const &row = this->adjList[item];
+
+    // Sort the edge indices so that the highest pheromones come first
+    std::vector<unsigned int> order(row.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::partial_sort(order.begin(), order.begin() + this->candidateSize, order.end(),
+        [&row](unsigned int a, unsigned int b) { return std::get<1>(row[a]) > std::get<1>(row[b]); });
+
+    // Keep the first `candidateSize` edges as candidates, and flag them so the fallback can skip them
+    this->candidates[item].assign(order.begin(), order.begin() + this->candidateSize);
+    this->isCandidate[item].assign(row.size(), false);
+    for (auto &idx: this->candidates[item])
+    {
+        this->isCandidate[item][idx] = true;
+    }
+
+    // Calculate the sum of all pheromones in the row (this is then kept up to date as pheromones change)
+    double rowSum = 0;
+    for (auto &edge: row)
+    {
+        rowSum += std::get<1>(edge);
+    }
+    this->rowSums[item] = rowSum;
+}
+
+int Graph::generateCandidateIdx(unsigned int item)
+{
+    // Function to pick a random index for the next node, weighted based on pheromone, only scanning
+    // every edge when the random number falls outside the candidate list
+    // Returns -1 if no choice can be made, in which case the caller scans the full row instead
+
+    // If this node has not been visited since its candidate list was cleared, build it
+    if (this->candidates[item].empty())
+        this->buildCandidates(item);
+
+    std::vector<Triple> const &row = this->adjList[item];
+    std::vector<unsigned int> const &itemCandidates = this->candidates[item];
+
+    // Calculate the sum of the candidate pheromones
+    double candidateSum = 0;
+    for (auto &idx: itemCandidates)
+    {
+        candidateSum += std::get<1>(row[idx]);
+    }
+
+    // If a pheromone is infinite (an ant found a fitness of 0), the sums cannot be used to weight a choice
+    if (!std::isfinite(candidateSum) || !std::isfinite(this->rowSums[item]) || this->rowSums[item] <= 0)
+        return -1;
+
+    // Pick at most twice: once with the kept row sum, and once more with the exact row sum if it had drifted
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        // Pick a random number in range 0 to sum of all pheromones
+        double r = distribution(this->rng) * this->rowSums[item];
+
+        // If the random number falls within the candidates, pick a candidate
+        double cumSum = 0;
+        if (r < candidateSum)
+        {
+            for (auto &idx: itemCandidates)
+            {
+                cumSum += std::get<1>(row[idx]);
+                if (cumSum >= r)
+                    return idx;
+            }
+            return itemCandidates.back();
+        }
+
+        // Otherwise fall back to scanning the rest of the row, skipping the candidates
+        // The whole row is scanned, so the exact row sum is recalculated along the way
+        r -= candidateSum;
+        int chosen = -1;
+        for (unsigned int idx = 0; idx < row.size(); idx++)
+        {
+            if (this->isCandidate[item][idx])
+                continue;
+
+            cumSum += std::get<1>(row[idx]);
+            if (chosen < 0 && cumSum >= r)
+                chosen = idx;
+        }
+        this->rowSums[item] = candidateSum + cumSum;
+
+        // If the random number was within the exact row sum, the choice is correctly weighted
+        if (chosen >= 0)
+            return chosen;
+
+        // Otherwise the kept row sum had drifted above the exact sum, so pick again using the exact sum
+    }
+
+    // No choice could be made, so leave it to the full row scan
+    return -1;
+}
+
 void Graph::addToBin(unsigned int bin, unsigned int weight)
 {
     // Add a given weight to the give bin
@@ -59,6 +210,14 @@ int Graph::generateIdx(unsigned int item)
 {
     // Function to pick a random index for the next node, weighted based on the pheromone of each edge
 
+    // If the candidate list is enabled and smaller than the row, use it instead of scanning every edge
+    if (this->candidateSize > 0 && this->candidateSize < this->adjList[item].size())
+    {
+        int candidateIdx = this->generateCandidateIdx(item);
+        if (candidateIdx >= 0)
+            return candidateIdx;
+    }
+
     // Initialise a vector of cumulative sums
     std::vector<float> weightCum;
     float cumSum = 0;
@@ -71,8 +230,8 @@ int Graph::generateIdx(unsigned int item)
     }
 
     // Pick a random number in range 0 to sum of all pheromones
-    float random = ((float) rand()) / (float) RAND_MAX;
-    float r = random * cumSum;
+    std::uniform_real_distribution<float> distribution(0.0, 1.0);
+    float r = distribution(this->rng) * cumSum;
 
     // Get index of the first element in weighted cumulative vector that is <= random number
     auto idx = std::lower_bound(weightCum.begin(), weightCum.end(), r);
@@ -182,10 +341,13 @@ void Graph::evaporatePheromone(float evaporationRate)
 {
     // Evaporates the pheromone based on given evaporation rate, for all edges
     // For every node in the adjacency list
-    for (auto &node: this->adjList)
+    for (unsigned int item = 0; item < this->adjList.size(); item++)
     {
+        // Sum of the evaporated pheromones from this node
+        double rowSum = 0;
+
         // For every edge from that node
-        for (auto &edge: node)
+        for (auto &edge: this->adjList[item])
         {
             // Get the destination and bin
             int destination = std::get<0>(edge);
@@ -199,7 +361,13 @@ void Graph::evaporatePheromone(float evaporationRate)
             Triple newEdge = std::make_tuple(destination, pheromone, bin);
             // Swap contents of old edge inplace of new edge
             std::swap(edge, newEdge);
+
+            rowSum += pheromone;
         }
+
+        // Every pheromone in a row is scaled equally, so the candidate list stays the same,
+        // but the row sum is replaced with the exact sum so it cannot drift between scans
+        this->rowSums[item] = rowSum;
     }
 }
 
@@ -238,6 +406,10 @@ void Graph::updatePheromone(std::vector<int> path, int fitness)
                     Triple newEdge = std::make_tuple(destination, pheromone, bin);
                     // Swap old edge inplace with new edge
                     std::swap(edge, newEdge);
+
+                    // If this node has a candidate list, keep it up to date
+                    if (!this->candidates[source].empty())
+                        this->updateCandidates(source, &edge - &this->adjList[source][0], fitnessDiff);
                 }
             } 
         }
@@ -250,6 +422,32 @@ void Graph::updatePheromone(std::vector<int> path, int fitness)
     }
 }
 
+void Graph::updateCandidates(unsigned int item, unsigned int idx, double increase)
+{
+    // Updates the candidate list of a node after the pheromone of one of its edges has increased
+    std::vector<Triple> const &row = this->adjList[item];
+    std::vector<unsigned int> &itemCandidates = this->candidates[item];
+
+    // Add the increase to the row sum
+    this->rowSums[item] += increase;
+
+    // If the edge is already a candidate, the candidate list is unchanged
+    if (this->isCandidate[item][idx])
+        return;
+
+    // Find the candidate with the lowest pheromone
+    auto lowest = std::min_element(itemCandidates.begin(), itemCandidates.end(),
+        [&row](unsigned int a, unsigned int b) { return std::get<1>(row[a]) < std::get<1>(row[b]); });
+
+    // If the edge now has a higher pheromone, it replaces that candidate
+    if (std::get<1>(row[idx]) > std::get<1>(row[*lowest]))
+    {
+        this->isCandidate[item][*lowest] = false;
+        this->isCandidate[item][idx] = true;
+        *lowest = idx;
+    }
+}
+
 void Graph::emptyBins()
 {
     // Sets weight of all bins to 0
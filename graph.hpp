@@ -5,6 +5,7 @@
 /*-- Includes --*/
 #include <vector>
 #include <tuple>
+#include <random>
 
 /* Defines the contents of an edge */
 struct Edge {
@@ -26,10 +27,39 @@ class Graph
         unsigned int numNodes;
         unsigned int problemType;
         unsigned int numItems;
+        std::mt19937 rng;
+        unsigned int candidateSize;
+        std::vector<std::vector<unsigned int>> candidates;
+        std::vector<std::vector<bool>> isCandidate;
+        std::vector<double> rowSums;
+
+        /* Builds the candidate list (highest pheromone edges) for a node */
+        void buildCandidates(unsigned int);
+
+        /* Gets index of next node using the candidate list, falling back to the rest of the row (-1 if no choice can be made) */
+        int generateCandidateIdx(unsigned int);
+
+        /* Updates the row sum and candidate list of a node after one of its edges is reinforced */
+        void updateCandidates(unsigned int, unsigned int, double);
     public:
         std::vector<std::vector<Triple>> adjList;
         Graph(std::vector<Edge> const &, unsigned int, unsigned int, unsigned int);
 
+        /* Gets number of bins in the graph */
+        unsigned int getNumBins() const;
+
+        /* Gets number of items in the graph */
+        unsigned int getNumItems() const;
+
+        /* Seeds the random number generator used for path generation */
+        void seed(unsigned int);
+
+        /* Sets every choice edge to a new random pheromone */
+        void resetPheromone();
+
+        /* Sets the candidate list size used when picking the next node (0 to always use every edge) */
+        void setCandidateSize(unsigned int);
+
         /* Adds a weight to a bin */
         void addToBin(unsigned int, unsigned int);
 
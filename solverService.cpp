@@ -0,0 +1,710 @@
+#include "solverService.hpp"
+#include "binPacking.hpp"
+#include "binPackingExceptions.hpp"
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <exception>
+#include <future>
+#include <algorithm>
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <errno.h>
+#endif
+
+/* Largest graph a job may request, in edges (around 3GB of adjacency list) */
+const long long MAX_INSTANCE_EDGES = 250000000;
+
+static void skipSpace(std::string const &line, size_t &pos)
+{
+    // Move position past any whitespace
+    while (pos < line.size() && isspace((unsigned char) line[pos]))
+    {
+        pos++;
+    }
+}
+
+static unsigned int parseHex(std::string const &line, size_t pos)
+{
+    // Parses the four hex digits of a \uXXXX escape starting at the given position
+    if (pos + 4 > line.size())
+        throw InvalidJobException();
+
+    unsigned int code = 0;
+    for (size_t i = pos; i < pos + 4; i++)
+    {
+        if (!isxdigit((unsigned char) line[i]))
+            throw InvalidJobException();
+        code = code * 16 + (isdigit((unsigned char) line[i]) ? line[i] - '0' : tolower((unsigned char) line[i]) - 'a' + 10);
+    }
+    return code;
+}
+
+static void appendUtf8(std::string &value, unsigned int code)
+{
+    // Appends a unicode code point to a string, encoded as UTF-8
+    if (code < 0x80)
+    {
+        value.push_back(code);
+    }
+    else if (code < 0x800)
+    {
+        value.push_back(0xC0 | (code >> 6));
+        value.push_back(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        value.push_back(0xE0 | (code >> 12));
+        value.push_back(0x80 | ((code >> 6) & 0x3F));
+        value.push_back(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        value.push_back(0xF0 | (code >> 18));
+        value.push_back(0x80 | ((code >> 12) & 0x3F));
+        value.push_back(0x80 | ((code >> 6) & 0x3F));
+        value.push_back(0x80 | (code & 0x3F));
+    }
+}
+
+static std::string parseString(std::string const &line, size_t &pos)
+{
+    // Parses a JSON string starting at the opening quote, leaving position after the closing quote
+    std::string value;
+    pos++;
+
+    while (pos < line.size() && line[pos] != '"')
+    {
+        // Handle escaped characters
+        if (line[pos] == '\\')
+        {
+            pos++;
+            if (pos >= line.size())
+                throw InvalidJobException();
+
+            char escaped = line[pos];
+            if (escaped == 'n')
+                value.push_back('\n');
+            else if (escaped == 't')
+                value.push_back('\t');
+            else if (escaped == 'r')
+                value.push_back('\r');
+            else if (escaped == 'b')
+                value.push_back('\b');
+            else if (escaped == 'f')
+                value.push_back('\f');
+            else if (escaped == '"' || escaped == '\\' || escaped == '/')
+                value.push_back(escaped);
+            else if (escaped == 'u')
+            {
+                unsigned int code = parseHex(line, pos + 1);
+                pos += 4;
+
+                // A high surrogate must be followed by an escaped low surrogate, which together make one code point
+                if (code >= 0xD800 && code <= 0xDBFF)
+                {
+                    if (pos + 2 >= line.size() || line[pos + 1] != '\\' || line[pos + 2] != 'u')
+                        throw InvalidJobException();
+                    unsigned int low = parseHex(line, pos + 3);
+                    if (low < 0xDC00 || low > 0xDFFF)
+                        throw InvalidJobException();
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    pos += 6;
+                }
+                // A low surrogate on its own is not a valid character
+                else if (code >= 0xDC00 && code <= 0xDFFF)
+                {
+                    throw InvalidJobException();
+                }
+                appendUtf8(value, code);
+            }
+            else
+                throw InvalidJobException();
+        }
+        else
+        {
+            value.push_back(line[pos]);
+        }
+        pos++;
+    }
+
+    // If the string was never closed
+    if (pos >= line.size())
+        throw InvalidJobException();
+
+    pos++;
+    return value;
+}
+
+static std::map<std::string, std::string> parseFields(std::string const &line)
+{
+    // Parses a flat JSON object into a map of keys to raw values
+    std::map<std::string, std::string> fields;
+    size_t pos = 0;
+
+    // Object must begin with an opening brace
+    skipSpace(line, pos);
+    if (pos >= line.size() || line[pos] != '{')
+        throw InvalidJobException();
+    pos++;
+
+    skipSpace(line, pos);
+    // Handle the empty object
+    if (pos < line.size() && line[pos] == '}')
+        return fields;
+
+    while (true)
+    {
+        // Parse the key
+        skipSpace(line, pos);
+        if (pos >= line.size() || line[pos] != '"')
+            throw InvalidJobException();
+        std::string key = parseString(line, pos);
+
+        // Parse the separating colon
+        skipSpace(line, pos);
+        if (pos >= line.size() || line[pos] != ':')
+            throw InvalidJobException();
+        pos++;
+
+        // Parse the value, either a string or a bare literal (number, true, false, null)
+        skipSpace(line, pos);
+        if (pos >= line.size())
+            throw InvalidJobException();
+
+        std::string value;
+        if (line[pos] == '"')
+        {
+            value = parseString(line, pos);
+        }
+        else
+        {
+            while (pos < line.size() && line[pos] != ',' && line[pos] != '}' && !isspace((unsigned char) line[pos]))
+            {
+                value.push_back(line[pos]);
+                pos++;
+            }
+            // Nested objects and arrays are not part of a job request
+            if (value.empty() || value[0] == '{' || value[0] == '[')
+                throw InvalidJobException();
+        }
+        fields[key] = value;
+
+        // Parse either the next separating comma or the closing brace
+        skipSpace(line, pos);
+        if (pos >= line.size())
+            throw InvalidJobException();
+        if (line[pos] == '}')
+            break;
+        if (line[pos] != ',')
+            throw InvalidJobException();
+        pos++;
+    }
+    return fields;
+}
+
+static Job makeJob(std::map<std::string, std::string> const &fields)
+{
+    // Builds a job from parsed fields, applying the same checks as the command line
+    Job job;
+
+    // Problem type, number of ants and evaporation rate are required
+    if (!fields.count("problem") || !fields.count("ants") || !fields.count("evaporation"))
+        throw InvalidJobException();
+
+    job.id = fields.count("id") ? fields.at("id") : "";
+
+    // Check that problem type is 1 or 2
+    job.problemType = std::stoi(fields.at("problem"));
+    if (job.problemType != 1 and job.problemType != 2)
+        throw InvalidProblemException();
+
+    // Check that number of ants is positive
+    job.numAnts = std::stoi(fields.at("ants"));
+    if (job.numAnts < 1)
+        throw InvalidNumAntsException();
+
+    // Check that evaporation is positive
+    job.evaporation = std::stof(fields.at("evaporation"));
+    if (job.evaporation < 0)
+        throw InvalidEvaporationRateException();
+
+    // Number of bins defaults to 10 for BPP1 and 50 for BPP2, number of items defaults to 500
+    job.numBins = fields.count("bins") ? std::stoi(fields.at("bins")) : (job.problemType == 1 ? 10 : 50);
+    job.numItems = fields.count("items") ? std::stoi(fields.at("items")) : 500;
+    if (job.numBins < 1 || job.numItems < 1)
+        throw InvalidInstanceException();
+
+    // Check that the graph (numBins edges from each of numBins * numItems nodes) is small enough to build,
+    // calculating in 64 bits so that large instances cannot overflow
+    long long numNodes = (long long) job.numBins * job.numItems;
+    if (numNodes > MAX_INSTANCE_EDGES || numNodes * job.numBins > MAX_INSTANCE_EDGES)
+        throw InvalidInstanceException();
+
+    // Budget defaults to the 10,000 fitness evaluations of a command line trial
+    job.budget = fields.count("budget") ? std::stoi(fields.at("budget")) : 10000;
+    if (job.budget < 1)
+        throw InvalidBudgetException();
+
+    // Candidate list size defaults to 0 (every edge is scanned when picking the next node)
+    job.candidateSize = fields.count("candidates") ? std::stoi(fields.at("candidates")) : 0;
+    if (job.candidateSize < 0)
+        throw InvalidCandidateSizeException();
+
+    // Seed defaults to a non-deterministic value
+    job.seed = fields.count("seed") ? std::stoul(fields.at("seed")) : std::random_device()();
+
+    return job;
+}
+
+static std::string escapeString(std::string const &value)
+{
+    // Escapes a string so it can be placed inside JSON quotes
+    std::string escaped;
+    for (char c: value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped.push_back('\\');
+            escaped.push_back(c);
+        }
+        else if (c == '\n')
+            escaped += "\\n";
+        else if (c == '\t')
+            escaped += "\\t";
+        else if (c == '\r')
+            escaped += "\\r";
+        else if (c == '\b')
+            escaped += "\\b";
+        else if (c == '\f')
+            escaped += "\\f";
+        // Every other control character is written as a \u00XX escape
+        else if ((unsigned char) c < 0x20)
+        {
+            char code[7];
+            snprintf(code, sizeof(code), "\\u%04x", (unsigned char) c);
+            escaped += code;
+        }
+        else
+            escaped.push_back(c);
+    }
+    return escaped;
+}
+
+static std::string errorResult(std::string const &id, char const *error)
+{
+    // Creates a result line for a job that could not be solved
+    return "{\"id\":\"" + escapeString(id) + "\",\"status\":\"error\",\"error\":\"" + escapeString(error) + "\"}";
+}
+
+StreamSink::StreamSink(std::ostream &out): out(out)
+{
+}
+
+void StreamSink::write(std::string const &result)
+{
+    // Write a whole line at a time, so results from different workers are not interleaved
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->out << result << std::endl;
+}
+
+SocketSink::SocketSink(int fd): fd(fd)
+{
+}
+
+SocketSink::~SocketSink()
+{
+#ifndef _WIN32
+    // Close the connection once no job needs to write to it
+    close(this->fd);
+#endif
+}
+
+void SocketSink::write(std::string const &result)
+{
+#ifndef _WIN32
+    // Write a whole line at a time, so results from different workers are not interleaved
+    std::lock_guard<std::mutex> guard(this->lock);
+    std::string line = result + "\n";
+
+    size_t sent = 0;
+    while (sent < line.size())
+    {
+        ssize_t written = ::write(this->fd, line.data() + sent, line.size() - sent);
+        // If the client has gone away, drop the result
+        if (written <= 0)
+            return;
+        sent += written;
+    }
+#endif
+}
+
+GraphCache::GraphCache(unsigned int capacity)
+{
+    // The cache always holds at least one graph
+    this->capacity = capacity > 0 ? capacity : 1;
+}
+
+static bool hasFailed(std::shared_future<std::shared_ptr<const Graph>> const &graph)
+{
+    // Checks whether a cached graph has finished building, but failed to build
+    if (graph.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    try
+    {
+        graph.get();
+        return false;
+    }
+    catch (...)
+    {
+        return true;
+    }
+}
+
+std::shared_ptr<const Graph> GraphCache::get(InstanceKey const &key)
+{
+    std::shared_future<std::shared_ptr<const Graph>> graph;
+    std::promise<std::shared_ptr<const Graph>> built;
+    bool building = false;
+
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+
+        // If the graph is cached (or being built by another job), move it to the front as the most recently used
+        auto found = this->index.find(key);
+        if (found != this->index.end())
+        {
+            this->entries.splice(this->entries.begin(), this->entries, found->second);
+            graph = found->second->second;
+        }
+        // Otherwise place a placeholder at the front, which this job fills once the graph is built
+        else
+        {
+            building = true;
+            graph = built.get_future().share();
+            this->entries.push_front(std::make_pair(key, graph));
+            this->index[key] = this->entries.begin();
+
+            // If over capacity, evict the least recently used graph (jobs still using it keep their copy alive)
+            if (this->entries.size() > this->capacity)
+            {
+                this->index.erase(this->entries.back().first);
+                this->entries.pop_back();
+            }
+        }
+    }
+
+    // If the graph is cached, wait for it (it may still be being built by another job)
+    if (!building)
+        return graph.get();
+
+    // Otherwise build the graph without holding the lock, so jobs on cached graphs are not held up
+    try
+    {
+        std::shared_ptr<const Graph> result = std::make_shared<const Graph>(buildGraph(std::get<0>(key), std::get<1>(key), std::get<2>(key)));
+        built.set_value(result);
+        return result;
+    }
+    catch (...)
+    {
+        // Pass the failure to any job waiting on the placeholder, and remove it so the next job can retry
+        built.set_exception(std::current_exception());
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            auto found = this->index.find(key);
+            if (found != this->index.end() && hasFailed(found->second->second))
+            {
+                this->entries.erase(found->second);
+                this->index.erase(found);
+            }
+        }
+        throw;
+    }
+}
+
+SolverService::SolverService(unsigned int numWorkers, unsigned int cacheSize, unsigned int maxQueued, unsigned int maxConnections): cache(cacheSize)
+{
+    // Initialise the class attributes (the queue and connection limits are always at least one)
+    this->inFlight = 0;
+    this->maxQueued = maxQueued > 0 ? maxQueued : 1;
+    this->numConnections = 0;
+    this->maxConnections = maxConnections > 0 ? maxConnections : 1;
+    this->stopping = false;
+
+    // Start the pool of worker threads (at least one)
+    if (numWorkers < 1)
+        numWorkers = 1;
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        this->workers.emplace_back(&SolverService::work, this);
+    }
+}
+
+SolverService::~SolverService()
+{
+    // Signal the workers to stop once the queue is empty, then wait for them
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->jobReady.notify_all();
+
+    for (auto &worker: this->workers)
+    {
+        worker.join();
+    }
+}
+
+void SolverService::work()
+{
+    while (true)
+    {
+        std::pair<Job, std::shared_ptr<ResultSink>> next;
+
+        // Wait for a job, or for the service to stop
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->jobReady.wait(guard, [this] { return this->stopping || !this->jobs.empty(); });
+
+            if (this->jobs.empty())
+                return;
+
+            next = this->jobs.front();
+            this->jobs.pop();
+        }
+        this->jobTaken.notify_one();
+
+        this->runJob(next.first, *next.second);
+
+        // Mark job as complete, waking anything waiting for the queue to drain
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->inFlight -= 1;
+        }
+        this->jobsDone.notify_all();
+    }
+}
+
+void SolverService::runJob(Job const &job, ResultSink &sink)
+{
+    try
+    {
+        // Take a private copy of the cached graph, so jobs never share pheromones
+        std::shared_ptr<const Graph> cached = this->cache.get(std::make_tuple(job.problemType, job.numBins, job.numItems));
+        Graph acoGraph(*cached);
+
+        // Seed the copy and give it fresh random pheromones from that seed
+        acoGraph.seed(job.seed);
+        acoGraph.resetPheromone();
+        acoGraph.setCandidateSize(job.candidateSize);
+
+        // Run the trial, tracking the elapsed time
+        auto start = std::chrono::system_clock::now();
+        double best = runTrial(acoGraph, job.numAnts, job.evaporation, job.budget);
+        std::chrono::duration<double> elapsedSeconds = std::chrono::system_clock::now() - start;
+
+        // Stream the result back
+        std::ostringstream result;
+        result << "{\"id\":\"" << escapeString(job.id) << "\",\"status\":\"ok\""
+            << ",\"problem\":" << job.problemType
+            << ",\"bins\":" << job.numBins
+            << ",\"items\":" << job.numItems
+            << ",\"ants\":" << job.numAnts
+            << ",\"evaporation\":" << job.evaporation
+            << ",\"seed\":" << job.seed
+            << ",\"budget\":" << job.budget
+            << ",\"candidates\":" << job.candidateSize
+            << ",\"best\":" << (long long) best
+            << ",\"elapsed\":" << elapsedSeconds.count() << "}";
+        sink.write(result.str());
+    }
+    catch (std::exception const &e)
+    {
+        // Any failure whilst solving is reported against the job rather than stopping the service
+        sink.write(errorResult(job.id, e.what()));
+    }
+}
+
+void SolverService::submit(std::string const &line, std::shared_ptr<ResultSink> sink)
+{
+    // Ignore blank lines
+    if (line.find_first_not_of(" \t\r") == std::string::npos)
+        return;
+
+    std::string id;
+    try
+    {
+        // Parse fields first, so errors in the job can still be reported against its id
+        std::map<std::string, std::string> fields = parseFields(line);
+        if (fields.count("id"))
+            id = fields.at("id");
+
+        Job job = makeJob(fields);
+
+        // Queue the job for the workers, waiting while the queue is full (this stops reading from the client)
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->jobTaken.wait(guard, [this] { return this->jobs.size() < this->maxQueued; });
+            this->jobs.push(std::make_pair(job, sink));
+            this->inFlight += 1;
+        }
+        this->jobReady.notify_one();
+    }
+    catch (std::invalid_argument const &e)
+    {
+        // Exception for fields of invalid data type
+        sink->write(errorResult(id, "Error: Cannot convert field to a number"));
+    }
+    catch (std::out_of_range const &e)
+    {
+        // Exception for fields out of range
+        sink->write(errorResult(id, "Error: Field out of range"));
+    }
+    catch (std::exception const &e)
+    {
+        // Exception for malformed or invalid job requests
+        sink->write(errorResult(id, e.what()));
+    }
+}
+
+void SolverService::drain()
+{
+    // Wait until there are no queued or running jobs
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->jobsDone.wait(guard, [this] { return this->inFlight == 0; });
+}
+
+void SolverService::serve(std::istream &in, std::ostream &out)
+{
+    // Results for every job are streamed to the same output
+    std::shared_ptr<ResultSink> sink = std::make_shared<StreamSink>(out);
+
+    // Submit each line as a job until the input ends
+    std::string line;
+    while (std::getline(in, line))
+    {
+        this->submit(line, sink);
+    }
+
+    // Wait for the remaining jobs to finish before returning
+    this->drain();
+}
+
+void SolverService::serveConnection(int fd)
+{
+#ifndef _WIN32
+    // Results for every job on this connection are streamed back to it
+    std::shared_ptr<ResultSink> sink = std::make_shared<SocketSink>(fd);
+
+    // Read from the socket, submitting each complete line as a job
+    std::string buffer;
+    char chunk[4096];
+    ssize_t received;
+    while ((received = read(fd, chunk, sizeof(chunk))) > 0)
+    {
+        buffer.append(chunk, received);
+
+        size_t newline;
+        while ((newline = buffer.find('\n')) != std::string::npos)
+        {
+            this->submit(buffer.substr(0, newline), sink);
+            buffer.erase(0, newline + 1);
+        }
+    }
+
+    // Submit any final line without a trailing newline
+    this->submit(buffer, sink);
+
+    // The socket is closed by the sink once the last queued job for it has finished
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        this->numConnections -= 1;
+    }
+    this->connectionClosed.notify_one();
+#endif
+}
+
+void SolverService::serveSocket(std::string const &path)
+{
+#ifdef _WIN32
+    // Unix domain sockets are not supported on this platform
+    throw ServiceSocketException();
+#else
+    // Check that the path fits in a socket address
+    struct sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path))
+        throw ServiceSocketException();
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+
+    // Ignore clients disconnecting before their results are written
+    signal(SIGPIPE, SIG_IGN);
+
+    // If a stale socket file is left at the path replace it, but never remove any other kind of file
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+            throw ServiceSocketException();
+        unlink(path.c_str());
+    }
+
+    // Create the socket
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        throw ServiceSocketException();
+
+    if (bind(listener, (struct sockaddr *) &address, sizeof(address)) < 0 || listen(listener, 16) < 0)
+    {
+        close(listener);
+        throw ServiceSocketException();
+    }
+
+    // Accept connections forever, reading each on its own thread
+    int backoff = 0;
+    while (true)
+    {
+        // Wait while at the connection limit
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->connectionClosed.wait(guard, [this] { return this->numConnections < this->maxConnections; });
+        }
+
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            // If the client gave up or the call was interrupted, try again straight away
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            // If out of file descriptors or memory, wait (up to a second) for jobs to finish and release them
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+            {
+                backoff = backoff > 0 ? std::min(backoff * 2, 1000) : 10;
+                std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+                continue;
+            }
+
+            // Any other error means the socket itself is broken
+            close(listener);
+            throw ServiceSocketException();
+        }
+        backoff = 0;
+
+        {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->numConnections += 1;
+        }
+        std::thread(&SolverService::serveConnection, this, fd).detach();
+    }
+#endif
+}
@@ -0,0 +1,128 @@
+/*-- This header defines the job struct, graph cache and solver service for solverService.cpp --*/
+#ifndef _SOLVERSERVICE_H
+#define _SOLVERSERVICE_H
+
+/*-- Includes --*/
+#include <string>
+#include <list>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <iostream>
+#include "graph.hpp"
+
+/* Defines the contents of a job request */
+struct Job {
+    std::string id;
+    int problemType;
+    int numBins;
+    int numItems;
+    int numAnts;
+    float evaporation;
+    unsigned int seed;
+    int budget;
+    int candidateSize;
+};
+
+/* Defines the key of a cached construction graph (problem type, number of bins, number of items) */
+typedef std::tuple<int, int, int> InstanceKey;
+
+/* Destination that job results are streamed back to */
+class ResultSink
+{
+    public:
+        virtual ~ResultSink() {}
+
+        /* Writes a single line of result JSON */
+        virtual void write(std::string const &) = 0;
+};
+
+/* Streams results to an output stream (e.g. stdout) */
+class StreamSink: public ResultSink
+{
+    private:
+        std::ostream &out;
+        std::mutex lock;
+    public:
+        StreamSink(std::ostream &);
+        void write(std::string const &);
+};
+
+/* Streams results to a connected socket, closing it once no jobs hold it */
+class SocketSink: public ResultSink
+{
+    private:
+        int fd;
+        std::mutex lock;
+    public:
+        SocketSink(int);
+        ~SocketSink();
+        void write(std::string const &);
+};
+
+/* Least recently used cache of built construction graphs, keyed by instance */
+class GraphCache
+{
+    private:
+        typedef std::pair<InstanceKey, std::shared_future<std::shared_ptr<const Graph>>> Entry;
+        unsigned int capacity;
+        std::list<Entry> entries;
+        std::map<InstanceKey, std::list<Entry>::iterator> index;
+        std::mutex lock;
+    public:
+        GraphCache(unsigned int);
+
+        /* Gets the graph for an instance, building it if it is not cached */
+        std::shared_ptr<const Graph> get(InstanceKey const &);
+};
+
+/* Long-running service that solves job requests on a pool of worker threads */
+class SolverService
+{
+    private:
+        GraphCache cache;
+        std::vector<std::thread> workers;
+        std::queue<std::pair<Job, std::shared_ptr<ResultSink>>> jobs;
+        std::mutex lock;
+        std::condition_variable jobReady;
+        std::condition_variable jobTaken;
+        std::condition_variable jobsDone;
+        std::condition_variable connectionClosed;
+        unsigned int inFlight;
+        unsigned int maxQueued;
+        unsigned int numConnections;
+        unsigned int maxConnections;
+        bool stopping;
+
+        /* Loop run by each worker thread */
+        void work();
+
+        /* Solves a single job and writes its result */
+        void runJob(Job const &, ResultSink &);
+
+        /* Reads job requests from a connected socket until it is closed */
+        void serveConnection(int);
+    public:
+        SolverService(unsigned int, unsigned int, unsigned int, unsigned int);
+        ~SolverService();
+
+        /* Parses a job request and queues it (waiting while the queue is full), writing an error result if it is invalid */
+        void submit(std::string const &, std::shared_ptr<ResultSink>);
+
+        /* Waits until all queued jobs are complete */
+        void drain();
+
+        /* Reads job requests from a stream until it ends */
+        void serve(std::istream &, std::ostream &);
+
+        /* Accepts connections on a Unix domain socket (waiting while at the connection limit) and reads job requests from each */
+        void serveSocket(std::string const &);
+};
+
+/*-- End Header --*/
+#endif